@@ -0,0 +1,69 @@
+#ifndef BENCHMARK_SUITE_H
+#define BENCHMARK_SUITE_H
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Timing statistics of one benchmark, in nanoseconds per access() pass
+struct BenchmarkStats {
+    std::string name;
+    size_t samples;
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double ci95;  // half-width of the 95% confidence interval of the mean
+};
+
+// Suite runner: named benchmark configs, each run with warm-up passes and
+// repeated timed passes, compared against a stored baseline
+class BenchmarkSuite {
+public:
+    BenchmarkSuite();
+
+    // Load suite file (see configs/suite.json)
+    bool load(const std::string& path);
+
+    // Override suite settings; negative values keep the suite file's.
+    // An explicit tolerance also overrides per-benchmark tolerances.
+    void set_warmup(int warmup);
+    void set_repetitions(int repetitions);
+    void set_tolerance(double tolerance);
+
+    // Run every benchmark; false if any failed to set up
+    bool run(bool verbose);
+
+    // Print statistics of all benchmarks
+    void report() const;
+
+    // Store results as a baseline file
+    bool save_baseline(const std::string& path) const;
+
+    // Compare against a baseline file; returns the number of regressions plus benchmarks
+    // missing from either side, -1 on error
+    int compare_baseline(const std::string& path) const;
+
+private:
+    struct Benchmark {
+        std::string name;
+        json config;
+        double tolerance;
+    };
+
+    int warmup_;
+    int repetitions_;
+    double tolerance_;
+    bool tolerance_override_;
+    std::vector<Benchmark> benchmarks_;
+    std::vector<BenchmarkStats> results_;
+
+    // Run one benchmark and collect samples (ns per pass)
+    bool run_benchmark(const Benchmark& benchmark, bool verbose, std::vector<double>* samples) const;
+
+    static BenchmarkStats compute_stats(const std::string& name, std::vector<double> samples);
+};
+
+#endif // BENCHMARK_SUITE_H
@@ -1,3 +1,6 @@
+#ifndef COMMON_H
+#define COMMON_H
+
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -7,6 +10,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <cstdlib>
 
 // Include NUMA headers only if available
 #ifdef HAVE_NUMA
@@ -14,7 +18,7 @@
 #include <numaif.h>
 #endif
 
-bool fill_random_value(void* memory_buffer, size_t size) {
+inline bool fill_random_value(void* memory_buffer, size_t size) {
     uint64_t* buf64 = static_cast<uint64_t*>(memory_buffer);
     size_t n64 = size / sizeof(uint64_t);
     uint64_t seed = reinterpret_cast<uintptr_t>(memory_buffer) ^ size;
@@ -24,7 +28,20 @@ bool fill_random_value(void* memory_buffer, size_t size) {
     return seed;
 }
 
-uint64_t parse_size_to_bytes(const std::string& input) {
+// Fast random number generator (wyhash64)
+inline uint64_t fast_rand_64bit(uint64_t *state) {
+    // refer to https://lemire.me/blog/2019/03/19/the-fastest-conventional-random-number-generator-that-can-pass-big-crush/
+    __uint128_t tmp;
+    uint64_t m1, m2;
+    *state += 0x60bee2bee120fc15;
+    tmp = (__uint128_t) (*state) * 0xa3b195354a39b70d;
+    m1 = (tmp >> 64) ^ tmp;
+    tmp = (__uint128_t)m1 * 0x1b03738712fad5c9;
+    m2 = (tmp >> 64) ^ tmp;
+    return m2;
+}
+
+inline uint64_t parse_size_to_bytes(const std::string& input) {
     std::string trimmed;
     for (char c : input) {
         if (!std::isspace(static_cast<unsigned char>(c))) trimmed += c;
@@ -62,7 +79,7 @@ uint64_t parse_size_to_bytes(const std::string& input) {
 }
 
 // Memory allocation function
-void* allocate_numa_memory(size_t size, int node) {
+inline void* allocate_numa_memory(size_t size, int node) {
     void* memory_buffer = nullptr;
     
 #ifdef HAVE_NUMA
@@ -121,7 +138,7 @@ void* allocate_numa_memory(size_t size, int node) {
 }
 
 // Memory deallocation function
-void deallocate_numa_memory(void* memory_buffer, size_t size) {
+inline void deallocate_numa_memory(void* memory_buffer, size_t size) {
     if (memory_buffer) {
 #ifdef HAVE_NUMA
         if (numa_available() >= 0) {
@@ -133,4 +150,6 @@ void deallocate_numa_memory(void* memory_buffer, size_t size) {
         free(memory_buffer);
 #endif
     }
-}
\ No newline at end of file
+}
+
+#endif // COMMON_H
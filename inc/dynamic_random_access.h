@@ -29,9 +29,6 @@ private:
     T* get_ptr_at_offset(size_t offset) const {
         return reinterpret_cast<T*>(static_cast<char*>(memory_buffer_) + offset);
     }
-    
-    // Fast random number generator (wyhash64)
-    uint64_t fast_rand_64bit(uint64_t *state);
 };
 
 #endif // DYNAMIC_RANDOM_ACCESS_H
@@ -0,0 +1,45 @@
+#ifndef INDIRECT_ACCESS_H
+#define INDIRECT_ACCESS_H
+
+#include "memory_access_base.h"
+#include <string>
+
+// Indirect access pattern implementation (gather: sum += A[B[i]], scatter: A[B[i]] = i)
+// The memory buffer is the data array A; the index array B is allocated
+// separately on "index_node" and streamed sequentially.
+class IndirectAccess : public MemoryAccessBase {
+public:
+    IndirectAccess();
+    ~IndirectAccess() override;
+
+    // Initialize indirect access pattern
+    bool init(void* memory_buffer, size_t memory_size, const json& config) override;
+
+    // Execute indirect access pattern
+    void access() override;
+
+    // Get pattern name
+    const char* get_pattern_name() const override { return "indirect"; }
+
+private:
+    void* memory_buffer_;  // Keep as void* for flexibility
+    size_t memory_size_;
+    int iteration_;
+    bool verbose_;
+    bool initialized_;
+    uint64_t random_state_;  // State for random number generator
+
+    // Indirect specific members
+    bool scatter_;            // false: gather, true: scatter
+    std::string index_pattern_;
+    std::string simd_;
+    int index_node_;
+    size_t data_elements_;
+    uint64_t* index_;         // Index array B
+    size_t index_count_;
+
+    // Helper method to fill the index array from index_pattern
+    bool build_index(const json& config);
+};
+
+#endif // INDIRECT_ACCESS_H
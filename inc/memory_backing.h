@@ -0,0 +1,60 @@
+#ifndef MEMORY_BACKING_H
+#define MEMORY_BACKING_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Backing store of the memory buffer, from the "backing" config options
+struct MemoryBacking {
+    std::string type = "anon";        // anon, memfd, shm, file or dax
+    std::string path;                 // shm object name, file path or dax device/file
+    bool shared = false;              // MAP_SHARED instead of MAP_PRIVATE
+    bool populate = false;            // MAP_POPULATE
+    std::vector<std::string> advice;  // madvise hints applied after mapping
+    bool init = true;                 // fill the buffer; false (default for file/dax) keeps contents
+    bool keep = false;                // keep a created shm object after exit
+
+    // Set by allocate_numa_memory() for mmap based buffers
+    bool mapped = false;
+    size_t mapped_size = 0;
+    bool created = false;
+};
+
+// Parse backing options from config
+bool parse_memory_backing(const json& config, MemoryBacking* backing);
+
+// Allocate a buffer with the given backing; plain anon uses the common.h allocator
+void* allocate_numa_memory(size_t size, int node, MemoryBacking& backing);
+
+// Release a buffer from allocate_numa_memory(size, node, backing)
+void deallocate_numa_memory(void* memory_buffer, size_t size, const MemoryBacking& backing);
+
+// Run the calling thread on the CPUs of node; negative node leaves it unbound
+void bind_to_node(int node);
+
+// Restrict allocations of the calling thread to node, so pages populated inside
+// mmap or madvise land there; false (and no policy) for an invalid node or without NUMA
+bool set_membind_policy(int node);
+
+// Undo set_membind_policy(), back to local allocation
+void reset_membind_policy();
+
+// Whether the running kernel supports MADV_POPULATE_READ/WRITE (Linux 5.14+)
+bool madvise_populate_supported();
+
+// Page fault counters of this process
+struct FaultCounters {
+    long minor;
+    long major;
+};
+
+FaultCounters read_fault_counters();
+
+// Number of pages of [memory_buffer, memory_buffer + size) resident in memory (page cache for files)
+size_t count_resident_pages(void* memory_buffer, size_t size, size_t* total_pages);
+
+#endif // MEMORY_BACKING_H
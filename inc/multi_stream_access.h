@@ -0,0 +1,45 @@
+#ifndef MULTI_STREAM_ACCESS_H
+#define MULTI_STREAM_ACCESS_H
+
+#include "memory_access_base.h"
+#include <string>
+#include <vector>
+
+// Multi-stream access pattern implementation
+// Interleaves S independent sequential/strided streams, each walking its
+// own region of the buffer, from a single thread. Sweeps over the values in
+// "stream_count" and reports bandwidth per S.
+class MultiStreamAccess : public MemoryAccessBase {
+public:
+    // Initialize multi-stream access pattern
+    bool init(void* memory_buffer, size_t memory_size, const json& config) override;
+
+    // Execute multi-stream access pattern
+    void access() override;
+
+    // Get pattern name
+    const char* get_pattern_name() const override { return "multi_stream"; }
+
+private:
+    void* memory_buffer_;  // Keep as void* for flexibility
+    size_t memory_size_;
+    int iteration_;
+    int access_stride_;
+    int byte_per_access_;
+    bool verbose_;
+    bool initialized_;
+
+    // Multi-stream specific members
+    std::vector<int> stream_counts_;
+    std::string direction_;     // forward, backward or alternate
+    size_t stream_spacing_;     // bytes per stream region, 0 for memory_size / S
+    size_t stream_offset_;      // extra bytes added per stream, keeps starts out of the same cache sets
+
+    // Helper method to walk stream_count interleaved streams, returns elapsed seconds
+    double walk_streams(int stream_count, size_t spacing, size_t* accesses);
+
+    // Region size per stream for stream_count streams
+    size_t region_spacing(int stream_count) const;
+};
+
+#endif // MULTI_STREAM_ACCESS_H
@@ -0,0 +1,48 @@
+#ifndef PAGE_FAULT_ACCESS_H
+#define PAGE_FAULT_ACCESS_H
+
+#include "memory_access_base.h"
+#include <string>
+#include <vector>
+
+// Page fault / memory population cost pattern implementation
+// Maps its own region of "fault_size" bytes (default memory_size) and times
+// how long it takes to populate it, either by first touch or MAP_POPULATE,
+// or by madvise(MADV_DONTNEED) and re-fault cycles.
+class PageFaultAccess : public MemoryAccessBase {
+public:
+    // Initialize page fault pattern
+    bool init(void* memory_buffer, size_t memory_size, const json& config) override;
+
+    // Execute page fault pattern
+    void access() override;
+
+    // Get pattern name
+    const char* get_pattern_name() const override { return "page_fault"; }
+
+private:
+    size_t memory_size_;
+    int iteration_;
+    int num_threads_;
+    int numa_node_;
+    bool verbose_;
+    bool initialized_;
+
+    // Page fault specific members
+    std::string page_type_;   // 4k, thp or hugetlb
+    std::string fault_mode_;  // first_touch or refault
+    bool populate_;           // MAP_POPULATE instead of lazy touch
+    bool write_touch_;        // write (allocating) instead of read touch
+    bool sample_latency_;     // record per-page fault latency
+    size_t page_size_;
+    size_t fault_size_;
+
+    // Helper methods to map and unmap the region, page aligned for page_type_
+    char* map_region();
+    void unmap_region(char* region);
+
+    // Helper method to touch every page with num_threads_ threads, returns elapsed seconds
+    double touch_region(char* region, std::vector<double>* latencies);
+};
+
+#endif // PAGE_FAULT_ACCESS_H
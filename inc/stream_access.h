@@ -0,0 +1,69 @@
+#ifndef STREAM_ACCESS_H
+#define STREAM_ACCESS_H
+
+#include "memory_access_base.h"
+#include <string>
+#include <vector>
+
+// STREAM-compatible bandwidth kernels (copy, scale, add, triad)
+//   copy  : c[j] = a[j]
+//   scale : b[j] = scalar * c[j]
+//   add   : c[j] = a[j] + b[j]
+//   triad : a[j] = b[j] + scalar * c[j]
+// Arrays are carved out of the memory buffer (a third each, "stream_offset"
+// bytes apart), or allocated separately on the nodes given by "stream_array_nodes".
+class StreamAccess : public MemoryAccessBase {
+public:
+    explicit StreamAccess(const std::string& kernel);
+    ~StreamAccess() override;
+
+    // Initialize stream kernel
+    bool init(void* memory_buffer, size_t memory_size, const json& config) override;
+
+    // Execute stream kernel
+    void access() override;
+
+    // Get pattern name
+    const char* get_pattern_name() const override { return kernel_name_.c_str(); }
+
+private:
+    enum class Kernel { Copy, Scale, Add, Triad };
+
+    std::string kernel_name_;
+    Kernel kernel_;
+    void* memory_buffer_;  // Keep as void* for flexibility
+    size_t memory_size_;
+    int iteration_;
+    int num_threads_;
+    int cpu_node_;
+    double scalar_;
+    bool verify_;
+    bool verbose_;
+    bool initialized_;
+
+    // Stream arrays, each holding array_elements_ doubles
+    size_t array_elements_;
+    double* arrays_[3];           // a, b, c
+    std::vector<int> array_nodes_;  // non-empty when arrays are allocated per node
+    size_t array_bytes_;
+    size_t array_offset_;           // padding between carved arrays (STREAM's OFFSET)
+
+    // Which of a, b, c the selected kernel touches
+    bool uses_array(int idx) const;
+
+    // Bytes moved per kernel invocation, by STREAM counting rules
+    size_t bytes_per_iteration() const;
+
+    // Run the kernel over [begin, end) elements
+    void run_kernel(size_t begin, size_t end);
+
+    // Fill arrays with their initial values over [begin, end) elements
+    void fill_arrays(size_t begin, size_t end);
+
+    // Check the arrays against the expected values after the runs
+    bool verify_results() const;
+
+    void release_arrays();
+};
+
+#endif // STREAM_ACCESS_H
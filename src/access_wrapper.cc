@@ -3,6 +3,10 @@
 #include "stride_access.h"
 #include "dynamic_random_access.h"
 #include "pointer_chase_access.h"
+#include "stream_access.h"
+#include "indirect_access.h"
+#include "multi_stream_access.h"
+#include "page_fault_access.h"
 #include <iostream>
 #include <memory>
 
@@ -23,6 +27,14 @@ std::unique_ptr<MemoryAccessBase> AccessWrapper::create_access_pattern(const std
         return std::unique_ptr<MemoryAccessBase>(new DynamicRandomAccess());
     } else if (pattern == "pointer_chase") {
         return std::unique_ptr<MemoryAccessBase>(new PointerChaseAccess());
+    } else if (pattern == "copy" || pattern == "scale" || pattern == "add" || pattern == "triad") {
+        return std::unique_ptr<MemoryAccessBase>(new StreamAccess(pattern));
+    } else if (pattern == "indirect") {
+        return std::unique_ptr<MemoryAccessBase>(new IndirectAccess());
+    } else if (pattern == "multi_stream") {
+        return std::unique_ptr<MemoryAccessBase>(new MultiStreamAccess());
+    } else if (pattern == "page_fault") {
+        return std::unique_ptr<MemoryAccessBase>(new PageFaultAccess());
     } else {
         std::cerr << "Unknown access pattern: " << pattern << std::endl;
         return nullptr;
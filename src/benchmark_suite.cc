@@ -0,0 +1,310 @@
+#include "benchmark_suite.h"
+#include "common.h"
+#include "memory_backing.h"
+#include "access_wrapper.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+const double kStudentT95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+double student_t95(size_t degrees) {
+    if (degrees == 0) {
+        return 0.0;
+    }
+    if (degrees <= 30) {
+        return kStudentT95[degrees - 1];
+    }
+    // Cornish-Fisher expansion around the normal quantile; within 0.001 of the exact quantile past 30
+    const double z = 1.959964;
+    double z3 = z * z * z;
+    double z5 = z3 * z * z;
+    double z7 = z5 * z * z;
+    double v = static_cast<double>(degrees);
+    return z + (z3 + z) / (4.0 * v) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * v * v) +
+           (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) / (384.0 * v * v * v);
+}
+
+// Discards output written to it; patterns print per-pass results
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+} // namespace
+
+BenchmarkSuite::BenchmarkSuite() : warmup_(1), repetitions_(10), tolerance_(0.05), tolerance_override_(false) {
+}
+
+bool BenchmarkSuite::load(const std::string& path) {
+    std::ifstream suite_file(path);
+    if (!suite_file.is_open()) {
+        std::cerr << "Error: Cannot open suite file: " << path << std::endl;
+        return false;
+    }
+
+    json suite;
+    try {
+        suite_file >> suite;
+    } catch (const json::exception& e) {
+        std::cerr << "Error: Cannot parse suite file " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    warmup_ = suite.value("warmup", warmup_);
+    repetitions_ = suite.value("repetitions", repetitions_);
+    tolerance_ = suite.value("tolerance", tolerance_);
+    json defaults = suite.value("defaults", json::object());
+
+    if (!suite.contains("benchmarks") || !suite["benchmarks"].is_array()) {
+        std::cerr << "Error: Suite file has no benchmarks array: " << path << std::endl;
+        return false;
+    }
+    for (const json& entry : suite["benchmarks"]) {
+        Benchmark benchmark;
+        benchmark.name = entry.value("name", std::string());
+        if (benchmark.name.empty()) {
+            std::cerr << "Error: Suite benchmark without a name" << std::endl;
+            return false;
+        }
+        for (const Benchmark& existing : benchmarks_) {
+            if (existing.name == benchmark.name) {
+                std::cerr << "Error: Duplicate suite benchmark name: " << benchmark.name << std::endl;
+                return false;
+            }
+        }
+        // Benchmark config is layered over the suite defaults
+        benchmark.config = defaults;
+        benchmark.config.update(entry.value("config", json::object()));
+        benchmark.tolerance = entry.value("tolerance", -1.0);
+        benchmarks_.push_back(benchmark);
+    }
+    return true;
+}
+
+void BenchmarkSuite::set_warmup(int warmup) {
+    if (warmup >= 0) {
+        warmup_ = warmup;
+    }
+}
+
+void BenchmarkSuite::set_repetitions(int repetitions) {
+    if (repetitions >= 0) {
+        repetitions_ = repetitions;
+    }
+}
+
+void BenchmarkSuite::set_tolerance(double tolerance) {
+    if (tolerance >= 0) {
+        tolerance_ = tolerance;
+        tolerance_override_ = true;
+    }
+}
+
+bool BenchmarkSuite::run(bool verbose) {
+    if (repetitions_ <= 0) {
+        std::cerr << "Error: repetitions must be positive, got: " << repetitions_ << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    results_.clear();
+    for (const Benchmark& benchmark : benchmarks_) {
+        std::cout << "Running " << benchmark.name << " (" << warmup_ << " warm-up, "
+                  << repetitions_ << " timed)" << std::endl;
+        std::vector<double> samples;
+        if (!run_benchmark(benchmark, verbose, &samples)) {
+            std::cerr << "Error: Benchmark " << benchmark.name << " failed" << std::endl;
+            ok = false;
+            continue;
+        }
+        results_.push_back(compute_stats(benchmark.name, samples));
+    }
+    return ok;
+}
+
+bool BenchmarkSuite::run_benchmark(const Benchmark& benchmark, bool verbose, std::vector<double>* samples) const {
+    json config = benchmark.config;
+    config["verbose"] = verbose;
+
+    // Alloc and init memory as main does for a single config
+    size_t mem_size_byte = parse_size_to_bytes(config.value("mem_size", std::string("1G")));
+    int numa_node = config.value("numa_node", 0);
+    const size_t ACCESS_UNIT_SIZE = 64;
+    size_t aligned_size = ((mem_size_byte + ACCESS_UNIT_SIZE - 1) / ACCESS_UNIT_SIZE) * ACCESS_UNIT_SIZE;
+
+    MemoryBacking backing;
+    if (!parse_memory_backing(config, &backing)) {
+        return false;
+    }
+    void* memory_buffer = allocate_numa_memory(aligned_size, numa_node, backing);
+    if (!memory_buffer) {
+        return false;
+    }
+
+    bool ok = true;
+    {
+        AccessWrapper access_wrapper;
+        std::string pattern = config.value("access_pattern", std::string("sequential"));
+        NullBuffer null_buffer;
+        std::streambuf* cout_buffer = std::cout.rdbuf();
+        if (!verbose) {
+            std::cout.rdbuf(&null_buffer);
+        }
+
+        if (access_wrapper.init(pattern, memory_buffer, aligned_size, config)) {
+            for (int it = 0; it < warmup_; it++) {
+                access_wrapper.access();
+            }
+            for (int it = 0; it < repetitions_; it++) {
+                auto start_timestamp = std::chrono::steady_clock::now();
+                access_wrapper.access();
+                auto end_timestamp = std::chrono::steady_clock::now();
+                samples->push_back(static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_timestamp - start_timestamp).count()));
+            }
+        } else {
+            ok = false;
+        }
+
+        std::cout.rdbuf(cout_buffer);
+    }
+
+    deallocate_numa_memory(memory_buffer, aligned_size, backing);
+    return ok;
+}
+
+BenchmarkStats BenchmarkSuite::compute_stats(const std::string& name, std::vector<double> samples) {
+    BenchmarkStats stats;
+    size_t n = samples.size();
+    std::sort(samples.begin(), samples.end());
+
+    stats.name = name;
+    stats.samples = n;
+    stats.min = samples.front();
+    stats.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+
+    double sum_sq = 0.0;
+    for (double sample : samples) {
+        sum_sq += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = n > 1 ? std::sqrt(sum_sq / (n - 1)) : 0.0;
+    stats.ci95 = n > 1 ? student_t95(n - 1) * stats.stddev / std::sqrt(static_cast<double>(n)) : 0.0;
+    return stats;
+}
+
+void BenchmarkSuite::report() const {
+    std::cout << std::left << std::setw(24) << "Benchmark" << std::right
+              << std::setw(6) << "N"
+              << std::setw(16) << "Min(ns)"
+              << std::setw(16) << "Median(ns)"
+              << std::setw(16) << "Mean(ns)"
+              << std::setw(14) << "Stddev(ns)"
+              << std::setw(16) << "95% CI(ns)" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    for (const BenchmarkStats& stats : results_) {
+        std::cout << std::left << std::setw(24) << stats.name << std::right
+                  << std::setw(6) << stats.samples
+                  << std::setw(16) << stats.min
+                  << std::setw(16) << stats.median
+                  << std::setw(16) << stats.mean
+                  << std::setw(14) << stats.stddev
+                  << std::setw(10) << "+/- " << std::setw(6) << stats.ci95 << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+bool BenchmarkSuite::save_baseline(const std::string& path) const {
+    json baseline;
+    baseline["benchmarks"] = json::object();
+    for (const BenchmarkStats& stats : results_) {
+        baseline["benchmarks"][stats.name] = {
+            {"samples", stats.samples},
+            {"min_ns", stats.min},
+            {"median_ns", stats.median},
+            {"mean_ns", stats.mean},
+            {"stddev_ns", stats.stddev},
+            {"ci95_ns", stats.ci95},
+        };
+    }
+
+    std::ofstream baseline_file(path);
+    if (!baseline_file.is_open()) {
+        std::cerr << "Error: Cannot write baseline file: " << path << std::endl;
+        return false;
+    }
+    baseline_file << baseline.dump(2) << std::endl;
+    std::cout << "Baseline saved to: " << path << std::endl;
+    return true;
+}
+
+int BenchmarkSuite::compare_baseline(const std::string& path) const {
+    std::ifstream baseline_file(path);
+    if (!baseline_file.is_open()) {
+        std::cerr << "Error: Cannot open baseline file: " << path << std::endl;
+        return -1;
+    }
+
+    json baseline;
+    try {
+        baseline_file >> baseline;
+    } catch (const json::exception& e) {
+        std::cerr << "Error: Cannot parse baseline file " << path << ": " << e.what() << std::endl;
+        return -1;
+    }
+    json entries = baseline.value("benchmarks", json::object());
+
+    // A benchmark regresses when its median exceeds the baseline median by more than the tolerance.
+    // Benchmarks only in this run or only in the baseline also fail the gate, so none goes unchecked.
+    int regressions = 0;
+    std::cout << "Comparing against baseline: " << path << std::endl;
+    for (const BenchmarkStats& stats : results_) {
+        if (!entries.contains(stats.name)) {
+            std::cout << "  " << std::left << std::setw(24) << stats.name << std::right << "new, no baseline  FAILED" << std::endl;
+            regressions++;
+            continue;
+        }
+        double tolerance = tolerance_;
+        for (const Benchmark& benchmark : benchmarks_) {
+            if (!tolerance_override_ && benchmark.name == stats.name && benchmark.tolerance >= 0) {
+                tolerance = benchmark.tolerance;
+            }
+        }
+
+        double base_median = entries[stats.name].value("median_ns", 0.0);
+        double change = base_median > 0 ? (stats.median - base_median) / base_median : 0.0;
+        const char* status = "ok";
+        if (change > tolerance) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (change < -tolerance) {
+            status = "improved";
+        }
+        std::cout << "  " << std::left << std::setw(24) << stats.name << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(14) << base_median << " -> " << std::setw(14) << stats.median
+                  << " ns  " << std::showpos << std::setprecision(1) << std::setw(7) << change * 100.0 << "%"
+                  << std::noshowpos << "  (tolerance " << std::setprecision(1) << tolerance * 100.0 << "%)  "
+                  << status << std::endl;
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        bool found = std::any_of(results_.begin(), results_.end(),
+                                 [&](const BenchmarkStats& stats) { return stats.name == it.key(); });
+        if (!found) {
+            std::cout << "  " << std::left << std::setw(24) << it.key() << std::right << "missing from this run  FAILED" << std::endl;
+            regressions++;
+        }
+    }
+    return regressions;
+}
@@ -1,4 +1,5 @@
 #include "dynamic_random_access.h"
+#include "common.h"
 #include <iostream>
 
 bool DynamicRandomAccess::init(void* memory_buffer, size_t memory_size, const json& config) {
@@ -57,16 +58,3 @@ void DynamicRandomAccess::access() {
         std::cout << "Dynamic random access pattern executed" << std::endl;
     }
 }
-
-uint64_t DynamicRandomAccess::fast_rand_64bit(uint64_t *state) {
-    // wyhash64
-    // refer to https://lemire.me/blog/2019/03/19/the-fastest-conventional-random-number-generator-that-can-pass-big-crush/
-    __uint128_t tmp;
-    uint64_t m1, m2;
-    *state += 0x60bee2bee120fc15;
-    tmp = (__uint128_t) (*state) * 0xa3b195354a39b70d;
-    m1 = (tmp >> 64) ^ tmp;
-    tmp = (__uint128_t)m1 * 0x1b03738712fad5c9;
-    m2 = (tmp >> 64) ^ tmp;
-    return m2;
-}
@@ -0,0 +1,274 @@
+#include "indirect_access.h"
+#include "common.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <immintrin.h>
+
+namespace {
+
+// Gather kernels: sum of data[index[i]] over [0, n)
+uint64_t gather_scalar(const uint64_t* data, const uint64_t* index, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += data[index[i]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+uint64_t gather_avx2(const uint64_t* data, const uint64_t* index, size_t n) {
+    const long long* base = reinterpret_cast<const long long*>(data);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i vidx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        acc = _mm256_add_epi64(acc, _mm256_i64gather_epi64(base, vidx, 8));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return sum + gather_scalar(data, index + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+uint64_t gather_avx512(const uint64_t* data, const uint64_t* index, size_t n) {
+    // Masked form with an explicit zero source (the unmasked one warns on GCC 12)
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i acc = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i vidx = _mm512_loadu_si512(index + i);
+        acc = _mm512_add_epi64(acc, _mm512_mask_i64gather_epi64(zero, 0xFF, vidx, data, 8));
+    }
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    uint64_t sum = 0;
+    for (int lane = 0; lane < 8; lane++) {
+        sum += lanes[lane];
+    }
+    return sum + gather_scalar(data, index + i, n - i);
+}
+
+// Scatter kernels: data[index[i]] = i over [0, n)
+void scatter_scalar(uint64_t* data, const uint64_t* index, size_t n, uint64_t first) {
+    for (size_t i = 0; i < n; i++) {
+        data[index[i]] = first + i;
+    }
+}
+
+// AVX2 has no scatter instruction; indices are loaded as vectors and stored per lane
+__attribute__((target("avx2")))
+void scatter_avx2(uint64_t* data, const uint64_t* index, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i vidx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        data[_mm256_extract_epi64(vidx, 0)] = i;
+        data[_mm256_extract_epi64(vidx, 1)] = i + 1;
+        data[_mm256_extract_epi64(vidx, 2)] = i + 2;
+        data[_mm256_extract_epi64(vidx, 3)] = i + 3;
+    }
+    scatter_scalar(data, index + i, n - i, i);
+}
+
+__attribute__((target("avx512f")))
+void scatter_avx512(uint64_t* data, const uint64_t* index, size_t n) {
+    __m512i vval = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i vstep = _mm512_set1_epi64(8);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i vidx = _mm512_loadu_si512(index + i);
+        _mm512_i64scatter_epi64(data, vidx, vval, 8);
+        vval = _mm512_add_epi64(vval, vstep);
+    }
+    scatter_scalar(data, index + i, n - i, i);
+}
+
+} // namespace
+
+IndirectAccess::IndirectAccess()
+    : memory_buffer_(nullptr), memory_size_(0), iteration_(0), verbose_(false),
+      initialized_(false), random_state_(0), scatter_(false), index_node_(0),
+      data_elements_(0), index_(nullptr), index_count_(0) {
+}
+
+IndirectAccess::~IndirectAccess() {
+    deallocate_numa_memory(index_, index_count_ * sizeof(uint64_t));
+}
+
+bool IndirectAccess::init(void* memory_buffer, size_t memory_size, const json& config) {
+    memory_buffer_ = memory_buffer;
+    memory_size_ = memory_size;
+    iteration_ = config.value("iteration", 1);
+    verbose_ = config.value("verbose", false);
+    random_state_ = config.value("random_seed", 12345);  // Default seed
+    index_pattern_ = config.value("index_pattern", std::string("random"));
+    simd_ = config.value("simd", std::string("scalar"));
+    index_node_ = config.value("index_node", config.value("numa_node", 0));
+    data_elements_ = memory_size_ / sizeof(uint64_t);
+
+    std::string op = config.value("indirect_op", std::string("gather"));
+    if (op != "gather" && op != "scatter") {
+        std::cerr << "Error: indirect_op must be gather or scatter, got: " << op << std::endl;
+        return false;
+    }
+    scatter_ = (op == "scatter");
+
+    if (simd_ == "avx2") {
+        if (!__builtin_cpu_supports("avx2")) {
+            std::cerr << "Error: simd avx2 requested but not supported by this CPU" << std::endl;
+            return false;
+        }
+    } else if (simd_ == "avx512") {
+        if (!__builtin_cpu_supports("avx512f")) {
+            std::cerr << "Error: simd avx512 requested but not supported by this CPU" << std::endl;
+            return false;
+        }
+    } else if (simd_ != "scalar") {
+        std::cerr << "Error: simd must be scalar, avx2 or avx512, got: " << simd_ << std::endl;
+        return false;
+    }
+
+    if (data_elements_ == 0) {
+        std::cerr << "Error: Memory too small for indirect access" << std::endl;
+        return false;
+    }
+
+    if (!build_index(config)) {
+        return false;
+    }
+    initialized_ = true;
+
+    if (verbose_) {
+        std::cout << "IndirectAccess initialized with: " << std::endl;
+        std::cout << "  memory_size: " << memory_size_ << std::endl;
+        std::cout << "  iteration: " << iteration_ << std::endl;
+        std::cout << "  indirect_op: " << op << std::endl;
+        std::cout << "  index_pattern: " << index_pattern_ << std::endl;
+        std::cout << "  index_count: " << index_count_ << std::endl;
+        std::cout << "  index_node: " << index_node_ << std::endl;
+        std::cout << "  simd: " << simd_ << std::endl;
+    }
+
+    return true;
+}
+
+void IndirectAccess::access() {
+    volatile uint64_t dummy_variable = 0;  // volatile to prevent optimization
+    if (!initialized_) {
+        std::cerr << "IndirectAccess not initialized" << std::endl;
+        return;
+    }
+
+    uint64_t* data = static_cast<uint64_t*>(memory_buffer_);
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iteration_; it++) {
+        if (scatter_) {
+            if (simd_ == "avx512") {
+                scatter_avx512(data, index_, index_count_);
+            } else if (simd_ == "avx2") {
+                scatter_avx2(data, index_, index_count_);
+            } else {
+                scatter_scalar(data, index_, index_count_, 0);
+            }
+        } else {
+            if (simd_ == "avx512") {
+                dummy_variable = gather_avx512(data, index_, index_count_);
+            } else if (simd_ == "avx2") {
+                dummy_variable = gather_avx2(data, index_, index_count_);
+            } else {
+                dummy_variable = gather_scalar(data, index_, index_count_);
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Prevent compiler from optimizing away the dummy variable
+    (void)dummy_variable;
+
+    double accesses = static_cast<double>(index_count_) * iteration_;
+    std::cout << "Indirect " << (scatter_ ? "scatter" : "gather") << " (" << simd_ << "): "
+              << accesses / elapsed / 1.0e6 << " M accesses/s, "
+              << elapsed * 1.0e9 / accesses << " ns/access, "
+              << "index stream " << accesses * sizeof(uint64_t) / elapsed / 1.0e6 << " MB/s" << std::endl;
+
+    if (verbose_) {
+        std::cout << "Indirect access pattern executed" << std::endl;
+    }
+}
+
+bool IndirectAccess::build_index(const json& config) {
+    std::vector<uint64_t> file_index;
+    if (index_pattern_ == "file") {
+        std::string path = config.value("index_file", std::string());
+        std::string format = config.value("index_file_format", std::string("binary"));
+        if (path.empty()) {
+            std::cerr << "Error: index_pattern file requires index_file" << std::endl;
+            return false;
+        }
+        std::ifstream in;
+        if (format == "binary") {
+            // Raw native-endian uint64_t entries
+            in.open(path, std::ios::binary);
+            uint64_t value;
+            while (in.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+                file_index.push_back(value);
+            }
+            if (in.gcount() != 0) {
+                std::cerr << "Error: Index file " << path << " has " << in.gcount() << " trailing bytes, its size "
+                          << "is not a multiple of " << sizeof(uint64_t) << std::endl;
+                return false;
+            }
+        } else if (format == "text") {
+            // Whitespace separated decimal entries
+            in.open(path);
+            uint64_t value;
+            while (in >> value) {
+                file_index.push_back(value);
+            }
+        } else {
+            std::cerr << "Error: index_file_format must be binary or text, got: " << format << std::endl;
+            return false;
+        }
+        if (!in.eof()) {
+            std::cerr << "Error: Failed to read index file: " << path << std::endl;
+            return false;
+        }
+        index_count_ = file_index.size();
+    } else if (index_pattern_ == "sequential" || index_pattern_ == "random") {
+        index_count_ = config.value("index_count", data_elements_);
+    } else {
+        std::cerr << "Error: index_pattern must be sequential, random or file, got: " << index_pattern_ << std::endl;
+        return false;
+    }
+
+    if (index_count_ == 0) {
+        std::cerr << "Error: Index array is empty" << std::endl;
+        return false;
+    }
+
+    // Index array lives on its own node, independent of the data array
+    index_ = static_cast<uint64_t*>(allocate_numa_memory(index_count_ * sizeof(uint64_t), index_node_));
+    if (!index_) {
+        std::cerr << "Error: Failed to allocate index array on NUMA node " << index_node_ << std::endl;
+        index_count_ = 0;
+        return false;
+    }
+
+    for (size_t i = 0; i < index_count_; i++) {
+        if (index_pattern_ == "file") {
+            if (file_index[i] >= data_elements_) {
+                std::cerr << "Error: Index " << file_index[i] << " at entry " << i
+                          << " is out of range (data elements: " << data_elements_ << ")" << std::endl;
+                return false;
+            }
+            index_[i] = file_index[i];
+        } else if (index_pattern_ == "sequential") {
+            index_[i] = i % data_elements_;
+        } else {
+            index_[i] = fast_rand_64bit(&random_state_) % data_elements_;
+        }
+    }
+    return true;
+}
@@ -4,9 +4,12 @@
 #include <CLI/CLI.hpp>
 #include <fstream>
 #include <chrono>
+#include <iomanip>
 
 #include "common.h"
+#include "memory_backing.h"
 #include "access_wrapper.h"
+#include "benchmark_suite.h"
 
 using json = nlohmann::json;
 
@@ -17,17 +20,73 @@ int main(int argc, char *argv[]) {
     std::string config_input;
     bool verbose = false;
     bool pause = false;
+    std::string suite_input;
+    std::string baseline_input;
+    std::string save_baseline_output;
+    int warmup = -1;
+    int repetitions = -1;
+    double tolerance = -1.0;
     
     // Add options to the app
-    app.add_option("-c,--config", config_input, "config file path")
-        ->required();
+    app.add_option("-c,--config", config_input, "config file path");
     
     app.add_flag("-v,--verbose", verbose, "Enable verbose output");
 
     app.add_flag("-p, --pause", pause, "Pause before access");
+
+    app.add_option("-s,--suite", suite_input, "suite file path, runs every benchmark in it instead of --config");
+
+    app.add_option("-b,--baseline", baseline_input, "baseline file to compare suite results against (exit 2 on regression)");
+
+    app.add_option("--save-baseline", save_baseline_output, "write suite results as a baseline file");
+
+    app.add_option("--warmup", warmup, "override suite warm-up passes");
+
+    app.add_option("--repetitions", repetitions, "override suite timed repetitions");
+
+    app.add_option("--tolerance", tolerance, "override suite and per-benchmark regression tolerance (0.05 = 5%)");
     
     // Parse command line arguments
     CLI11_PARSE(app, argc, argv);
+
+    if (!suite_input.empty()) {
+        BenchmarkSuite suite;
+        if (!suite.load(suite_input)) {
+            return 1;
+        }
+        suite.set_warmup(warmup);
+        suite.set_repetitions(repetitions);
+        suite.set_tolerance(tolerance);
+
+        bool ok = suite.run(verbose);
+        suite.report();
+        // A baseline missing a failed benchmark would leave it ungated on later runs
+        if (!ok) {
+            if (!save_baseline_output.empty()) {
+                std::cerr << "Error: Baseline not saved, some benchmarks failed" << std::endl;
+            }
+            return 1;
+        }
+        if (!save_baseline_output.empty() && !suite.save_baseline(save_baseline_output)) {
+            return 1;
+        }
+        if (!baseline_input.empty()) {
+            int regressions = suite.compare_baseline(baseline_input);
+            if (regressions < 0) {
+                return 1;
+            }
+            if (regressions > 0) {
+                std::cerr << regressions << " benchmark(s) regressed beyond tolerance or do not match the baseline" << std::endl;
+                return 2;
+            }
+        }
+        return 0;
+    }
+
+    if (config_input.empty()) {
+        std::cerr << "Error: --config or --suite is required" << std::endl;
+        return 1;
+    }
     
     // Read and parse config file
     std::ifstream config_file(config_input);
@@ -54,7 +113,12 @@ int main(int argc, char *argv[]) {
     const size_t ACCESS_UNIT_SIZE = 64;
     size_t aligned_size = ((mem_size_byte + ACCESS_UNIT_SIZE - 1) / ACCESS_UNIT_SIZE) * ACCESS_UNIT_SIZE;
     
-    void* memory_buffer = allocate_numa_memory(aligned_size, numa_node);
+    MemoryBacking backing;
+    if (!parse_memory_backing(config, &backing)) {
+        return 1;
+    }
+
+    void* memory_buffer = allocate_numa_memory(aligned_size, numa_node, backing);
     if (!memory_buffer) {
         std::cerr << "Failed to allocate memory" << std::endl;
         return 1;
@@ -64,6 +128,8 @@ int main(int argc, char *argv[]) {
         std::cout << "Memory allocated successfully:" << std::endl;
         std::cout << "  Size: " << mem_size_str << " (" << aligned_size << " bytes)" << std::endl;
         std::cout << "  NUMA node: " << numa_node << std::endl;
+        std::cout << "  Backing: " << backing.type << (backing.path.empty() ? "" : " " + backing.path)
+                  << (backing.shared ? " (MAP_SHARED)" : " (MAP_PRIVATE)") << std::endl;
     }
 
 
@@ -74,7 +140,7 @@ int main(int argc, char *argv[]) {
     config["verbose"] = verbose;
     if (!access_wrapper.init(pattern, memory_buffer, aligned_size, config)) {
         std::cerr << "Failed to initialize AccessWrapper" << std::endl;
-        deallocate_numa_memory(memory_buffer, aligned_size);
+        deallocate_numa_memory(memory_buffer, aligned_size, backing);
         return 1;
     }
     
@@ -83,20 +149,38 @@ int main(int argc, char *argv[]) {
         std::cin.get();
     }
 
-    // Get the start timestamp (in milliseconds since epoch)
+    // Page cache residency and fault counts are reported for non-default backings
+    bool report_faults = verbose || backing.type != "anon";
+    size_t total_pages = 0;
+    size_t resident_before = report_faults ? count_resident_pages(memory_buffer, aligned_size, &total_pages) : 0;
+    FaultCounters faults_before = read_fault_counters();
+
+    // Get the start timestamp
     auto start_timestamp = std::chrono::steady_clock::now();
 
     // run access wrapper
     access_wrapper.access();
 
-    // Get the end timestamp (in milliseconds since epoch)
+    // Get the end timestamp, measured in nanoseconds so small working sets do not read as 0 ms
     auto end_timestamp = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_timestamp - start_timestamp);
-    std::cout << "Time taken: " << duration.count() << " milliseconds" << std::endl; // TODO : print result
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_timestamp - start_timestamp);
+    std::cout << "Time taken: " << std::fixed << std::setprecision(3) << duration.count() / 1.0e6
+              << " milliseconds (" << duration.count() << " ns)" << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(6);
+
+    if (report_faults) {
+        FaultCounters faults_after = read_fault_counters();
+        size_t resident_after = count_resident_pages(memory_buffer, aligned_size, &total_pages);
+        std::cout << "Page faults: minor " << faults_after.minor - faults_before.minor
+                  << ", major " << faults_after.major - faults_before.major << std::endl;
+        std::cout << "Resident pages: " << resident_before << " -> " << resident_after
+                  << " of " << total_pages << " (" << total_pages - resident_before
+                  << " not resident before access)" << std::endl;
+    }
     
 
     // Clean up memory before exit
-    deallocate_numa_memory(memory_buffer, aligned_size);
+    deallocate_numa_memory(memory_buffer, aligned_size, backing);
 
     return 0;
 }
\ No newline at end of file
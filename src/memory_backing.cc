@@ -0,0 +1,304 @@
+#include "memory_backing.h"
+#include "common.h"
+#include <iostream>
+#include <unordered_map>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+bool parse_madvise_hint(const std::string& hint, int* advice) {
+    static const std::unordered_map<std::string, int> advice_table = {
+        {"normal", MADV_NORMAL}, {"random", MADV_RANDOM}, {"sequential", MADV_SEQUENTIAL},
+        {"willneed", MADV_WILLNEED}, {"hugepage", MADV_HUGEPAGE}, {"nohugepage", MADV_NOHUGEPAGE},
+#ifdef MADV_POPULATE_READ
+        {"populate_read", MADV_POPULATE_READ}, {"populate_write", MADV_POPULATE_WRITE},
+#endif
+    };
+    auto it = advice_table.find(hint);
+    if (it == advice_table.end()) {
+        return false;
+    }
+    *advice = it->second;
+    return true;
+}
+
+} // namespace
+
+bool parse_memory_backing(const json& config, MemoryBacking* backing) {
+    backing->type = config.value("backing", std::string("anon"));
+    backing->path = config.value("backing_path", std::string());
+    backing->shared = config.value("map_shared", backing->type != "anon");
+    backing->populate = config.value("map_populate", false);
+    // Existing files keep their contents unless initialization is asked for explicitly
+    bool file_backed = backing->type == "file" || backing->type == "dax";
+    backing->init = config.value("backing_init", !file_backed);
+    backing->keep = config.value("backing_keep", false);
+    if (config.contains("madvise")) {
+        if (config["madvise"].is_array()) {
+            backing->advice = config["madvise"].get<std::vector<std::string>>();
+        } else {
+            backing->advice = {config["madvise"].get<std::string>()};
+        }
+    }
+
+    const std::string& type = backing->type;
+    if (type != "anon" && type != "memfd" && type != "shm" && type != "file" && type != "dax") {
+        std::cerr << "Error: backing must be anon, memfd, shm, file or dax, got: " << type << std::endl;
+        return false;
+    }
+    if ((type == "file" || type == "dax") && backing->path.empty()) {
+        std::cerr << "Error: backing " << type << " requires backing_path" << std::endl;
+        return false;
+    }
+    if (type == "dax" && !backing->shared) {
+        std::cerr << "Error: backing dax requires map_shared" << std::endl;
+        return false;
+    }
+    if (type == "file" && !backing->shared && backing->init) {
+        std::cerr << "Error: backing file with map_shared false and backing_init true would turn every page "
+                  << "into an anonymous copy, so the file is never read; drop one of them" << std::endl;
+        return false;
+    }
+    if (type == "shm" && backing->path.empty()) {
+        backing->path = "/pattern_access";
+    }
+    return true;
+}
+
+
+// Memory allocation function for non-default backings: mmap of anon, memfd,
+// shm, regular file or dax memory, bound to the NUMA node where the kernel honours it
+void* allocate_numa_memory(size_t size, int node, MemoryBacking& backing) {
+    if (backing.type == "anon" && !backing.shared && !backing.populate && backing.advice.empty()) {
+        return allocate_numa_memory(size, node);
+    }
+
+    int fd = -1;
+    size_t map_size = size;
+    bool dax_file = false;  // fsdax file, which needs MAP_SYNC to bypass the page cache
+    int flags = backing.shared ? MAP_SHARED : MAP_PRIVATE;
+    bool numa_bind = backing.type == "anon" || backing.type == "memfd" || backing.type == "shm";
+
+    // The mapping is populated after mbind and madvise hints when the kernel supports
+    // MADV_POPULATE_*; otherwise MAP_POPULATE runs inside mmap, under a membind policy for the node
+    bool madvise_populate = backing.populate && madvise_populate_supported();
+    if (backing.populate && !madvise_populate) {
+        flags |= MAP_POPULATE;
+    }
+
+    if (backing.type == "anon") {
+        flags |= MAP_ANONYMOUS;
+    } else if (backing.type == "memfd") {
+        fd = memfd_create("pattern_access", 0);
+    } else if (backing.type == "shm") {
+        fd = shm_open(backing.path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            backing.created = true;
+        } else if (errno == EEXIST) {
+            fd = shm_open(backing.path.c_str(), O_RDWR, 0600);
+        }
+    } else if (backing.type == "file") {
+        fd = open(backing.path.c_str(), O_RDWR | O_CREAT, 0644);
+    } else {
+        fd = open(backing.path.c_str(), O_RDWR);
+    }
+    if (backing.type != "anon" && fd < 0) {
+        std::cerr << "Failed to open " << backing.type << " backing " << backing.path
+                  << ": " << strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            std::cerr << "Failed to stat backing " << backing.path << ": " << strerror(errno) << std::endl;
+            close(fd);
+            return nullptr;
+        }
+        if (S_ISCHR(st.st_mode)) {
+            // devdax mappings must be aligned to the device alignment (2 MB by default)
+            const size_t DAX_ALIGN = 2UL << 20;
+            map_size = (size + DAX_ALIGN - 1) / DAX_ALIGN * DAX_ALIGN;
+        } else if (static_cast<size_t>(st.st_size) < size && ftruncate(fd, size) != 0) {
+            std::cerr << "Failed to resize backing " << backing.path << " to " << size
+                      << " bytes: " << strerror(errno) << std::endl;
+            close(fd);
+            return nullptr;
+        }
+        dax_file = backing.type == "dax" && !S_ISCHR(st.st_mode);
+    }
+
+    bool bind_policy = backing.populate && !madvise_populate && numa_bind && set_membind_policy(node);
+
+    void* memory_buffer = MAP_FAILED;
+    int map_errno = 0;
+#ifdef MAP_SYNC
+    // fsdax files are mapped synchronously so stores reach media without page cache;
+    // a file MAP_SYNC is refused for lives in the page cache and is not dax at all
+    if (backing.type == "dax") {
+        memory_buffer = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, flags | MAP_SHARED_VALIDATE | MAP_SYNC, fd, 0);
+        map_errno = errno;
+        if (memory_buffer == MAP_FAILED && dax_file) {
+            std::cerr << "Failed to mmap dax backing " << backing.path << " with MAP_SYNC: " << strerror(map_errno)
+                      << (map_errno == EOPNOTSUPP ? " (not on a dax filesystem; use backing file)" : "") << std::endl;
+        }
+    }
+#else
+    if (dax_file) {
+        std::cerr << "Warning: MAP_SYNC unavailable, dax backing " << backing.path
+                  << " may be served from the page cache" << std::endl;
+    }
+#endif
+    if (memory_buffer == MAP_FAILED && !dax_file) {
+        memory_buffer = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, flags, fd, 0);
+        map_errno = errno;
+    }
+    if (bind_policy) {
+        reset_membind_policy();
+    }
+    if (fd >= 0) {
+        close(fd);  // the mapping keeps the backing alive
+    }
+    if (memory_buffer == MAP_FAILED) {
+        if (!dax_file) {
+            std::cerr << "Failed to mmap " << backing.type << " backing: " << strerror(map_errno) << std::endl;
+        }
+        return nullptr;
+    }
+    backing.mapped = true;
+    backing.mapped_size = map_size;
+
+#ifdef HAVE_NUMA
+    // Page cache and pmem placement is not controlled by memory policy
+    if (numa_bind && numa_available() >= 0) {
+        if (node < 0 || node > numa_max_node()) {
+            std::cerr << "Invalid NUMA node " << node << ", using node 0" << std::endl;
+            node = 0;
+        }
+        numa_tonode_memory(memory_buffer, map_size, node);
+    }
+#else
+    (void)node;
+    (void)numa_bind;
+#endif
+
+    for (const std::string& hint : backing.advice) {
+        int advice = 0;
+        if (!parse_madvise_hint(hint, &advice)) {
+            std::cerr << "Warning: Unknown madvise hint " << hint << ", ignored" << std::endl;
+        } else if (madvise(memory_buffer, map_size, advice) != 0) {
+            std::cerr << "Warning: madvise " << hint << " failed: " << strerror(errno) << std::endl;
+        }
+    }
+
+#ifdef MADV_POPULATE_WRITE
+    // Private file mappings are populated by reading, so pages stay in the page cache
+    if (madvise_populate) {
+        bool file_private = !backing.shared && backing.type != "anon";
+        if (madvise(memory_buffer, map_size, file_private ? MADV_POPULATE_READ : MADV_POPULATE_WRITE) != 0) {
+            std::cerr << "Warning: populating " << backing.type << " backing failed: " << strerror(errno) << std::endl;
+        }
+    }
+#endif
+
+    if (backing.init) {
+        memset(memory_buffer, 0, size);
+        if (!fill_random_value(memory_buffer, size)) {
+            std::cerr << "Failed to fill memory buffer with random value" << std::endl;
+            return nullptr;
+        }
+    }
+
+    return memory_buffer;
+}
+
+void deallocate_numa_memory(void* memory_buffer, size_t size, const MemoryBacking& backing) {
+    if (!backing.mapped) {
+        deallocate_numa_memory(memory_buffer, size);
+        return;
+    }
+    if (memory_buffer) {
+        munmap(memory_buffer, backing.mapped_size);
+    }
+    if (backing.type == "shm" && backing.created && !backing.keep) {
+        shm_unlink(backing.path.c_str());
+    }
+}
+
+void bind_to_node(int node) {
+#ifdef HAVE_NUMA
+    if (node >= 0 && numa_available() >= 0 && numa_run_on_node(node) != 0) {
+        std::cerr << "Warning: failed to bind thread to NUMA node " << node << std::endl;
+    }
+#else
+    (void)node;
+#endif
+}
+
+bool set_membind_policy(int node) {
+#ifdef HAVE_NUMA
+    if (numa_available() < 0 || node < 0 || node > numa_max_node()) {
+        return false;
+    }
+    struct bitmask* nodes = numa_allocate_nodemask();
+    numa_bitmask_setbit(nodes, node);
+    numa_set_membind(nodes);
+    numa_free_nodemask(nodes);
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+void reset_membind_policy() {
+#ifdef HAVE_NUMA
+    numa_set_localalloc();
+#endif
+}
+
+bool madvise_populate_supported() {
+#ifdef MADV_POPULATE_WRITE
+    // Headers may be newer than the kernel, which rejects unknown advice with EINVAL
+    static const bool supported = []() {
+        size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        void* probe = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (probe == MAP_FAILED) {
+            return false;
+        }
+        bool ok = madvise(probe, page_size, MADV_POPULATE_WRITE) == 0 || errno != EINVAL;
+        munmap(probe, page_size);
+        return ok;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+FaultCounters read_fault_counters() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return FaultCounters{usage.ru_minflt, usage.ru_majflt};
+}
+
+// Number of pages of [memory_buffer, memory_buffer + size) resident in memory (page cache for files)
+size_t count_resident_pages(void* memory_buffer, size_t size, size_t* total_pages) {
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    *total_pages = (size + page_size - 1) / page_size;
+    std::vector<unsigned char> residency(*total_pages);
+    if (mincore(memory_buffer, size, residency.data()) != 0) {
+        return 0;
+    }
+    size_t resident = 0;
+    for (unsigned char page : residency) {
+        resident += page & 1;
+    }
+    return resident;
+}
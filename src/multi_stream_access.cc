@@ -0,0 +1,168 @@
+#include "multi_stream_access.h"
+#include "common.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+
+bool MultiStreamAccess::init(void* memory_buffer, size_t memory_size, const json& config) {
+    memory_buffer_ = memory_buffer;
+    memory_size_ = memory_size;
+    iteration_ = config.value("iteration", 1);
+    access_stride_ = config.value("access_stride", 1);
+    byte_per_access_ = config.value("byte_per_access", 64);
+    verbose_ = config.value("verbose", false);
+    direction_ = config.value("stream_direction", std::string("forward"));
+    initialized_ = false;
+
+    // stream_count is either a single value or a list to sweep
+    if (!config.contains("stream_count")) {
+        stream_counts_ = {1, 2, 4, 8, 16, 32, 64};
+    } else if (config["stream_count"].is_array()) {
+        stream_counts_ = config["stream_count"].get<std::vector<int>>();
+    } else {
+        stream_counts_ = {config["stream_count"].get<int>()};
+    }
+
+    // stream_spacing accepts a byte count or a size string such as "64M"
+    stream_spacing_ = 0;
+    if (config.contains("stream_spacing")) {
+        if (config["stream_spacing"].is_string()) {
+            stream_spacing_ = parse_size_to_bytes(config["stream_spacing"].get<std::string>());
+        } else {
+            stream_spacing_ = config["stream_spacing"].get<size_t>();
+        }
+    }
+
+    // Like STREAM's OFFSET, shift each stream by a cache line by default so that
+    // power-of-two spacings do not map every stream start to the same cache sets
+    stream_offset_ = config.value("stream_offset", stream_spacing_ ? static_cast<size_t>(0) : static_cast<size_t>(64));
+
+    // Validate byte_per_access is power of 2
+    if (byte_per_access_ <= 0 || (byte_per_access_ & (byte_per_access_ - 1)) != 0) {
+        std::cerr << "Error: byte_per_access must be a power of 2, got: " << byte_per_access_ << std::endl;
+        return false;
+    }
+    if (access_stride_ <= 0) {
+        std::cerr << "Error: access_stride must be positive, got: " << access_stride_ << std::endl;
+        return false;
+    }
+    if (direction_ != "forward" && direction_ != "backward" && direction_ != "alternate") {
+        std::cerr << "Error: stream_direction must be forward, backward or alternate, got: " << direction_ << std::endl;
+        return false;
+    }
+    for (int count : stream_counts_) {
+        if (count <= 0) {
+            std::cerr << "Error: stream_count must be positive, got: " << count << std::endl;
+            return false;
+        }
+        if (stream_offset_ * (count - 1) >= memory_size_ ||
+            (stream_spacing_ != 0 && stream_spacing_ * count + stream_offset_ * (count - 1) > memory_size_)) {
+            std::cerr << "Error: " << count << " streams with stream_spacing " << stream_spacing_
+                      << " and stream_offset " << stream_offset_ << " exceed memory_size " << memory_size_ << std::endl;
+            return false;
+        }
+        // Each stream needs room for at least one access
+        size_t stride_bytes = static_cast<size_t>(access_stride_) * byte_per_access_;
+        if (region_spacing(count) < stride_bytes) {
+            std::cerr << "Error: " << count << " streams leave " << region_spacing(count)
+                      << " bytes per stream, less than one access_stride of " << stride_bytes << " bytes" << std::endl;
+            return false;
+        }
+    }
+    initialized_ = true;
+
+    if (verbose_) {
+        std::cout << "MultiStreamAccess initialized with: " << std::endl;
+        std::cout << "  memory_size: " << memory_size_ << std::endl;
+        std::cout << "  iteration: " << iteration_ << std::endl;
+        std::cout << "  access_stride: " << access_stride_ << std::endl;
+        std::cout << "  byte_per_access: " << byte_per_access_ << std::endl;
+        std::cout << "  stream_direction: " << direction_ << std::endl;
+        std::cout << "  stream_spacing: " << (stream_spacing_ ? std::to_string(stream_spacing_) : "memory_size / S") << std::endl;
+        std::cout << "  stream_offset: " << stream_offset_ << std::endl;
+        std::cout << "  stream_count:";
+        for (int count : stream_counts_) {
+            std::cout << " " << count;
+        }
+        std::cout << std::endl;
+    }
+
+    return true;
+}
+
+void MultiStreamAccess::access() {
+    if (!initialized_) {
+        std::cerr << "MultiStreamAccess not initialized" << std::endl;
+        return;
+    }
+
+    // Bandwidth counts cache lines touched: strides under a line reuse it
+    size_t stride_bytes = static_cast<size_t>(access_stride_) * byte_per_access_;
+    size_t bytes_per_access = std::min<size_t>(stride_bytes, 64);
+
+    std::cout << "Streams  Spacing(B)    Accesses      Time(s)    MB/s" << std::endl;
+    for (int count : stream_counts_) {
+        size_t spacing = region_spacing(count);
+        size_t accesses = 0;
+        double elapsed = walk_streams(count, spacing, &accesses);
+        std::cout << std::setw(7) << count << "  " << std::setw(10) << spacing << "  "
+                  << std::setw(10) << accesses << "  " << std::fixed << std::setprecision(6)
+                  << std::setw(11) << elapsed << "  " << std::setprecision(1)
+                  << 1.0e-6 * accesses * bytes_per_access / elapsed << std::endl;
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    if (verbose_) {
+        std::cout << "Multi-stream access pattern executed" << std::endl;
+    }
+}
+
+double MultiStreamAccess::walk_streams(int stream_count, size_t spacing, size_t* accesses) {
+    volatile uint64_t dummy_variable = 0;  // volatile to prevent optimization
+    size_t stride_bytes = static_cast<size_t>(access_stride_) * byte_per_access_;
+    size_t steps = spacing / stride_bytes;
+    if (steps == 0) {
+        *accesses = 0;
+        return 0.0;
+    }
+
+    std::vector<const char*> start(stream_count);
+    std::vector<ptrdiff_t> delta(stream_count);
+    for (int s = 0; s < stream_count; s++) {
+        const char* region = static_cast<const char*>(memory_buffer_) + s * (spacing + stream_offset_);
+        bool backward = direction_ == "backward" || (direction_ == "alternate" && (s & 1));
+        start[s] = backward ? region + (steps - 1) * stride_bytes : region;
+        delta[s] = backward ? -static_cast<ptrdiff_t>(stride_bytes) : static_cast<ptrdiff_t>(stride_bytes);
+    }
+
+    std::vector<const char*> cursor(stream_count);
+    uint64_t sum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int it = 0; it < iteration_; it++) {
+        std::copy(start.begin(), start.end(), cursor.begin());
+        // Advance every stream by one access per step, round robin
+        for (size_t step = 0; step < steps; step++) {
+            for (int s = 0; s < stream_count; s++) {
+                sum += *reinterpret_cast<const uint64_t*>(cursor[s]);
+                cursor[s] += delta[s];
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    // Prevent compiler from optimizing away the loads
+    dummy_variable = sum;
+    (void)dummy_variable;
+
+    *accesses = steps * stream_count * static_cast<size_t>(iteration_);
+    return elapsed;
+}
+
+size_t MultiStreamAccess::region_spacing(int stream_count) const {
+    if (stream_spacing_) {
+        return stream_spacing_;
+    }
+    size_t spacing = (memory_size_ - stream_offset_ * (stream_count - 1)) / stream_count;
+    return spacing / byte_per_access_ * byte_per_access_;
+}
@@ -0,0 +1,361 @@
+#include "page_fault_access.h"
+#include "common.h"
+#include "memory_backing.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <fstream>
+#include <cerrno>
+#include <sys/mman.h>
+
+namespace {
+
+const size_t kBasePageSize = 4096;
+const size_t kHugePageSize = 2UL << 20;
+const char* kThpEnabledPath = "/sys/kernel/mm/transparent_hugepage/enabled";
+
+struct PhaseStats {
+    const char* name;
+    double seconds;
+    long faults;
+};
+
+} // namespace
+
+bool PageFaultAccess::init(void* memory_buffer, size_t memory_size, const json& config) {
+    // The memory buffer itself is not touched; the pattern maps its own region
+    (void)memory_buffer;
+    memory_size_ = memory_size;
+    iteration_ = config.value("iteration", 1);
+    num_threads_ = config.value("threads", 1);
+    numa_node_ = config.value("numa_node", 0);
+    verbose_ = config.value("verbose", false);
+    page_type_ = config.value("fault_page", std::string("4k"));
+    fault_mode_ = config.value("fault_mode", std::string("first_touch"));
+    std::string populate = config.value("fault_populate", std::string("lazy"));
+    std::string touch = config.value("fault_access", std::string("write"));
+    populate_ = populate == "populate";
+    write_touch_ = touch == "write";
+    sample_latency_ = config.value("fault_sample_latency", false);
+    initialized_ = false;
+
+    fault_size_ = memory_size_;
+    if (config.contains("fault_size")) {
+        fault_size_ = parse_size_to_bytes(config["fault_size"].get<std::string>());
+    }
+
+    if (page_type_ == "4k") {
+        page_size_ = kBasePageSize;
+    } else if (page_type_ == "thp" || page_type_ == "hugetlb") {
+        page_size_ = kHugePageSize;
+    } else {
+        std::cerr << "Error: fault_page must be 4k, thp or hugetlb, got: " << page_type_ << std::endl;
+        return false;
+    }
+    if (fault_mode_ != "first_touch" && fault_mode_ != "refault") {
+        std::cerr << "Error: fault_mode must be first_touch or refault, got: " << fault_mode_ << std::endl;
+        return false;
+    }
+    if (populate != "lazy" && populate != "populate") {
+        std::cerr << "Error: fault_populate must be lazy or populate, got: " << populate << std::endl;
+        return false;
+    }
+    if (touch != "write" && touch != "read") {
+        std::cerr << "Error: fault_access must be write or read, got: " << touch << std::endl;
+        return false;
+    }
+    if (populate_ && fault_mode_ == "refault") {
+        std::cerr << "Error: fault_populate populate only applies to fault_mode first_touch" << std::endl;
+        return false;
+    }
+    if (page_type_ == "thp") {
+        // madvise(MADV_HUGEPAGE) only helps when THP is "always" or "madvise"
+        std::ifstream thp_file(kThpEnabledPath);
+        std::string thp_enabled;
+        if (!std::getline(thp_file, thp_enabled) || thp_enabled.find("[never]") != std::string::npos) {
+            std::cerr << "Error: fault_page thp requires transparent huge pages, " << kThpEnabledPath << " is "
+                      << (thp_enabled.empty() ? "unavailable" : thp_enabled) << std::endl;
+            return false;
+        }
+    }
+    // Populate must follow MADV_NOHUGEPAGE / MADV_HUGEPAGE, which MAP_POPULATE cannot do
+    if (populate_ && page_type_ != "hugetlb" && !madvise_populate_supported()) {
+        std::cerr << "Error: fault_populate with " << page_type_
+                  << " pages requires MADV_POPULATE_WRITE (Linux 5.14+)" << std::endl;
+        return false;
+    }
+    if (num_threads_ <= 0) {
+        std::cerr << "Error: threads must be positive, got: " << num_threads_ << std::endl;
+        return false;
+    }
+#ifdef HAVE_NUMA
+    if (numa_available() >= 0 && (numa_node_ < 0 || numa_node_ > numa_max_node())) {
+        std::cerr << "Error: numa_node must be between 0 and " << numa_max_node() << ", got: " << numa_node_ << std::endl;
+        return false;
+    }
+#endif
+
+    fault_size_ = fault_size_ / page_size_ * page_size_;
+    if (fault_size_ == 0) {
+        std::cerr << "Error: fault_size smaller than one " << page_type_ << " page" << std::endl;
+        return false;
+    }
+    initialized_ = true;
+
+    if (verbose_) {
+        std::cout << "PageFaultAccess initialized with: " << std::endl;
+        std::cout << "  fault_size: " << fault_size_ << std::endl;
+        std::cout << "  iteration: " << iteration_ << std::endl;
+        std::cout << "  threads: " << num_threads_ << std::endl;
+        std::cout << "  fault_page: " << page_type_ << std::endl;
+        std::cout << "  fault_mode: " << fault_mode_ << std::endl;
+        std::cout << "  fault_populate: " << (populate_ ? "populate" : "lazy") << std::endl;
+        std::cout << "  fault_access: " << (write_touch_ ? "write" : "read") << std::endl;
+        std::cout << "  fault_sample_latency: " << (sample_latency_ ? "true" : "false") << std::endl;
+    }
+
+    return true;
+}
+
+void PageFaultAccess::access() {
+    if (!initialized_) {
+        std::cerr << "PageFaultAccess not initialized" << std::endl;
+        return;
+    }
+    if (iteration_ <= 0) {
+        return;
+    }
+
+    bool refault = fault_mode_ == "refault";
+    PhaseStats phases[3] = {
+        {refault ? "dontneed" : (populate_ ? "populate" : "map"), 0.0, 0},
+        {refault ? "refault" : "touch", 0.0, 0},
+        {"unmap", 0.0, 0},
+    };
+    std::vector<double> latencies;
+
+    auto timed = [](PhaseStats* phase, const std::function<void()>& body) {
+        FaultCounters before = read_fault_counters();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        phase->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        phase->faults += read_fault_counters().minor - before.minor;
+    };
+
+    char* region = nullptr;
+    if (refault) {
+        // Populate once untimed; every iteration then zaps and re-faults the same range
+        region = map_region();
+        if (!region) {
+            return;
+        }
+        touch_region(region, nullptr);
+    }
+
+    for (int it = 0; it < iteration_; it++) {
+        if (refault) {
+            timed(&phases[0], [&]() {
+                if (madvise(region, fault_size_, MADV_DONTNEED) != 0) {
+                    std::cerr << "Error: madvise MADV_DONTNEED failed: " << strerror(errno) << std::endl;
+                }
+            });
+        } else {
+            timed(&phases[0], [&]() { region = map_region(); });
+            if (!region) {
+                return;
+            }
+        }
+
+        // Touch time excludes thread start-up, so it is taken from touch_region()
+        FaultCounters before = read_fault_counters();
+        phases[1].seconds += touch_region(region, sample_latency_ ? &latencies : nullptr);
+        phases[1].faults += read_fault_counters().minor - before.minor;
+
+        // THP falls back to 4 KB pages silently: a touch per 2 MB then leaves most of the
+        // region absent, and populate takes a fault per 4 KB page
+        if (page_type_ == "thp" && it == 0) {
+            size_t total_pages = 0;
+            size_t resident = count_resident_pages(region, fault_size_, &total_pages);
+            size_t huge_pages = fault_size_ / page_size_;
+            if (resident < total_pages || phases[0].faults > static_cast<long>(2 * huge_pages)) {
+                std::cerr << "Warning: thp region is not backed by huge pages (" << resident << " of "
+                          << total_pages << " 4 KB pages resident, " << phases[0].faults + phases[1].faults
+                          << " faults for " << huge_pages << " huge pages)" << std::endl;
+            }
+        }
+
+        if (!refault) {
+            timed(&phases[2], [&]() { unmap_region(region); });
+            region = nullptr;
+        }
+    }
+    if (refault) {
+        timed(&phases[2], [&]() { unmap_region(region); });
+        // Single unmap; scaled so the per-pass division below reports it as is
+        phases[2].seconds *= iteration_;
+        phases[2].faults *= iteration_;
+    }
+
+    size_t pages = fault_size_ / page_size_;
+    std::cout << "Page fault " << page_type_ << " " << fault_mode_ << " ("
+              << (populate_ ? "populate" : "lazy") << ", " << (write_touch_ ? "write" : "read")
+              << ", " << num_threads_ << " threads): " << pages << " pages of " << page_size_
+              << " bytes per pass" << std::endl;
+    std::cout << "Phase          ms/pass     ns/page      GB/s   faults/pass" << std::endl;
+    for (const PhaseStats& phase : phases) {
+        double seconds = phase.seconds / iteration_;
+        std::cout << std::left << std::setw(10) << phase.name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(3) << seconds * 1.0e3
+                  << std::setw(12) << std::setprecision(1) << seconds * 1.0e9 / pages
+                  << std::setw(10) << std::setprecision(2) << fault_size_ / seconds / (1UL << 30)
+                  << std::setw(14) << phase.faults / iteration_ << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) {
+            return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+        };
+        std::cout << std::fixed << std::setprecision(0)
+                  << "Per-page touch latency (ns): p50 " << percentile(0.50) << ", p99 " << percentile(0.99)
+                  << ", p99.9 " << percentile(0.999) << ", max " << latencies.back() << std::endl;
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    if (verbose_) {
+        std::cout << "Page fault pattern executed" << std::endl;
+    }
+}
+
+char* PageFaultAccess::map_region() {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* region = MAP_FAILED;
+
+    // Pages populated inside mmap or madvise are placed by the thread's policy, not mbind
+    bool bind_policy = populate_ && set_membind_policy(numa_node_);
+
+    if (page_type_ == "hugetlb") {
+        flags |= MAP_HUGETLB;
+#ifdef MAP_HUGE_2MB
+        flags |= MAP_HUGE_2MB;
+#endif
+        region = mmap(nullptr, fault_size_, PROT_READ | PROT_WRITE, flags | (populate_ ? MAP_POPULATE : 0), -1, 0);
+    } else if (page_type_ == "4k") {
+        // Mapped lazily so MADV_NOHUGEPAGE is in place before any page is populated
+        region = mmap(nullptr, fault_size_, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (region != MAP_FAILED) {
+            madvise(region, fault_size_, MADV_NOHUGEPAGE);
+        }
+    } else {
+        // Over-map so the region can be trimmed to a huge page boundary
+        char* raw = static_cast<char*>(mmap(nullptr, fault_size_ + kHugePageSize, PROT_READ | PROT_WRITE, flags, -1, 0));
+        if (raw != MAP_FAILED) {
+            char* aligned = reinterpret_cast<char*>(
+                (reinterpret_cast<uintptr_t>(raw) + kHugePageSize - 1) & ~(kHugePageSize - 1));
+            if (aligned != raw) {
+                munmap(raw, aligned - raw);
+            }
+            munmap(aligned + fault_size_, raw + kHugePageSize - aligned);
+            region = aligned;
+            if (madvise(aligned, fault_size_, MADV_HUGEPAGE) != 0) {
+                int advise_errno = errno;
+                std::cerr << "Error: madvise MADV_HUGEPAGE failed: " << strerror(advise_errno) << std::endl;
+                munmap(aligned, fault_size_);
+                region = MAP_FAILED;
+                errno = advise_errno;
+            }
+        }
+    }
+    int map_errno = errno;
+
+#ifdef MADV_POPULATE_WRITE
+    // A failed populate would move every fault into the touch row, so it is an error
+    if (populate_ && page_type_ != "hugetlb" && region != MAP_FAILED &&
+        madvise(region, fault_size_, MADV_POPULATE_WRITE) != 0) {
+        map_errno = errno;
+        std::cerr << "Error: madvise MADV_POPULATE_WRITE failed: " << strerror(map_errno) << std::endl;
+        munmap(region, fault_size_);
+        region = MAP_FAILED;
+    }
+#endif
+
+    if (bind_policy) {
+        reset_membind_policy();
+    }
+#ifdef HAVE_NUMA
+    if (!bind_policy && region != MAP_FAILED && numa_available() >= 0) {
+        numa_tonode_memory(region, fault_size_, numa_node_);
+    }
+#endif
+
+    if (region == MAP_FAILED) {
+        std::cerr << "Error: Failed to map " << fault_size_ << " bytes of " << page_type_
+                  << " pages: " << strerror(map_errno) << std::endl;
+        return nullptr;
+    }
+
+    return static_cast<char*>(region);
+}
+
+void PageFaultAccess::unmap_region(char* region) {
+    if (region) {
+        munmap(region, fault_size_);
+    }
+}
+
+double PageFaultAccess::touch_region(char* region, std::vector<double>* latencies) {
+    size_t pages = fault_size_ / page_size_;
+    std::vector<std::vector<double>> samples(num_threads_);
+    std::atomic<bool> go(false);
+    std::atomic<uint64_t> sink(0);
+
+    auto worker = [&](int tid) {
+        size_t chunk = (pages + num_threads_ - 1) / num_threads_;
+        size_t begin = std::min(pages, chunk * tid);
+        size_t end = std::min(pages, begin + chunk);
+        uint64_t sum = 0;
+        if (latencies) {
+            samples[tid].reserve(end - begin);
+        }
+        bind_to_node(numa_node_);
+        while (!go.load(std::memory_order_acquire)) {
+        }
+        for (size_t page = begin; page < end; page++) {
+            volatile char* ptr = region + page * page_size_;
+            auto start = latencies ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            if (write_touch_) {
+                *ptr = 1;
+            } else {
+                sum += *ptr;
+            }
+            if (latencies) {
+                samples[tid].push_back(std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start).count());
+            }
+        }
+        sink.fetch_add(sum, std::memory_order_relaxed);
+    };
+
+    std::vector<std::thread> workers;
+    for (int tid = 0; tid < num_threads_; tid++) {
+        workers.emplace_back(worker, tid);
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) {
+        w.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (latencies) {
+        for (const auto& thread_samples : samples) {
+            latencies->insert(latencies->end(), thread_samples.begin(), thread_samples.end());
+        }
+    }
+    return elapsed;
+}
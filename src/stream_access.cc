@@ -0,0 +1,370 @@
+#include "stream_access.h"
+#include "common.h"
+#include "memory_backing.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Initial values, as in STREAM (c is non-zero so scale has a non-trivial result)
+const double kInitValue[3] = {1.0, 2.0, 0.5};
+
+// Keep thread chunks on cache line boundaries
+const size_t kChunkAlign = 64 / sizeof(double);
+
+// Sense-reversing spin barrier, so that kernel timing does not include
+// thread wake-up latency
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int count) : count_(count), waiting_(0), sense_(false) {}
+
+    void wait() {
+        bool sense = sense_.load(std::memory_order_relaxed);
+        if (waiting_.fetch_add(1, std::memory_order_acq_rel) == count_ - 1) {
+            waiting_.store(0, std::memory_order_relaxed);
+            sense_.store(!sense, std::memory_order_release);
+        } else {
+            while (sense_.load(std::memory_order_acquire) == sense) {
+            }
+        }
+    }
+
+private:
+    const int count_;
+    std::atomic<int> waiting_;
+    std::atomic<bool> sense_;
+};
+
+// Kernels are kept as plain loops over restrict pointers; this file is
+// compiled with optimization so they are auto-vectorized, and each kernel is
+// cloned per ISA and dispatched at load time so the binary stays portable.
+#define STREAM_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+
+STREAM_KERNEL
+void kernel_copy(double* __restrict__ c, const double* __restrict__ a, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        c[j] = a[j];
+    }
+}
+
+STREAM_KERNEL
+void kernel_scale(double* __restrict__ b, const double* __restrict__ c, double scalar, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        b[j] = scalar * c[j];
+    }
+}
+
+STREAM_KERNEL
+void kernel_add(double* __restrict__ c, const double* __restrict__ a, const double* __restrict__ b, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        c[j] = a[j] + b[j];
+    }
+}
+
+STREAM_KERNEL
+void kernel_triad(double* __restrict__ a, const double* __restrict__ b, const double* __restrict__ c,
+                  double scalar, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        a[j] = b[j] + scalar * c[j];
+    }
+}
+
+// Split [0, n) into num_threads cache line aligned chunks
+void thread_range(size_t n, int num_threads, int tid, size_t* begin, size_t* end) {
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    chunk = (chunk + kChunkAlign - 1) / kChunkAlign * kChunkAlign;
+    *begin = std::min(n, chunk * tid);
+    *end = std::min(n, *begin + chunk);
+}
+
+} // namespace
+
+StreamAccess::StreamAccess(const std::string& kernel)
+    : kernel_name_(kernel), kernel_(Kernel::Copy), memory_buffer_(nullptr), memory_size_(0),
+      iteration_(0), num_threads_(1), cpu_node_(-1), scalar_(3.0), verify_(false),
+      verbose_(false), initialized_(false), array_elements_(0), arrays_{nullptr, nullptr, nullptr},
+      array_bytes_(0), array_offset_(0) {
+    if (kernel == "scale") {
+        kernel_ = Kernel::Scale;
+    } else if (kernel == "add") {
+        kernel_ = Kernel::Add;
+    } else if (kernel == "triad") {
+        kernel_ = Kernel::Triad;
+    }
+}
+
+StreamAccess::~StreamAccess() {
+    release_arrays();
+}
+
+bool StreamAccess::init(void* memory_buffer, size_t memory_size, const json& config) {
+    memory_buffer_ = memory_buffer;
+    memory_size_ = memory_size;
+    iteration_ = config.value("iteration", 10);  // STREAM default NTIMES
+    num_threads_ = config.value("threads", 1);
+    cpu_node_ = config.value("cpu_node", -1);
+    scalar_ = config.value("stream_scalar", 3.0);
+    verify_ = config.value("verify", false);
+    verbose_ = config.value("verbose", false);
+    array_nodes_ = config.value("stream_array_nodes", std::vector<int>());
+    // Like STREAM's OFFSET, pad between carved arrays by a cache line so that
+    // a[j], b[j] and c[j] do not share cache sets or 4K-alias at power-of-two sizes
+    array_offset_ = config.value("stream_offset", static_cast<size_t>(64));
+
+    if (num_threads_ <= 0) {
+        std::cerr << "Error: threads must be positive, got: " << num_threads_ << std::endl;
+        return false;
+    }
+    if (!array_nodes_.empty() && array_nodes_.size() != 3) {
+        std::cerr << "Error: stream_array_nodes must list the nodes of a, b and c, got "
+                  << array_nodes_.size() << " entries" << std::endl;
+        return false;
+    }
+    if (array_offset_ % sizeof(double) != 0) {
+        std::cerr << "Error: stream_offset must be a multiple of " << sizeof(double) << ", got: "
+                  << array_offset_ << std::endl;
+        return false;
+    }
+    if (!array_nodes_.empty()) {
+        array_offset_ = 0;  // separate allocations, nothing to pad
+    }
+
+    // Each array takes a third of the memory size less padding, as STREAM's three arrays do.
+    // With padding, arrays of a page or more are whole pages so the padding alone sets
+    // their starts apart mod 4K.
+    const size_t page_elements = 4096 / sizeof(double);
+    size_t padding = 2 * array_offset_;
+    array_elements_ = memory_size_ > padding ? (memory_size_ - padding) / 3 / sizeof(double) : 0;
+    size_t align = array_offset_ && array_elements_ >= page_elements ? page_elements : kChunkAlign;
+    array_elements_ = array_elements_ / align * align;
+    array_bytes_ = array_elements_ * sizeof(double);
+    if (array_elements_ == 0) {
+        std::cerr << "Error: Memory too small for stream arrays" << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (!uses_array(i)) {
+            continue;
+        }
+        if (array_nodes_.empty()) {
+            arrays_[i] = reinterpret_cast<double*>(static_cast<char*>(memory_buffer_) + i * (array_bytes_ + array_offset_));
+        } else {
+            arrays_[i] = static_cast<double*>(allocate_numa_memory(array_bytes_, array_nodes_[i]));
+            if (!arrays_[i]) {
+                std::cerr << "Error: Failed to allocate stream array on NUMA node " << array_nodes_[i] << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Fill arrays from the worker threads so each thread's chunk is warm in its caches
+    std::vector<std::thread> workers;
+    for (int tid = 0; tid < num_threads_; tid++) {
+        workers.emplace_back([this, tid]() {
+            size_t begin, end;
+            bind_to_node(cpu_node_);
+            thread_range(array_elements_, num_threads_, tid, &begin, &end);
+            fill_arrays(begin, end);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    initialized_ = true;
+
+    if (verbose_) {
+        std::cout << "StreamAccess initialized with: " << std::endl;
+        std::cout << "  kernel: " << kernel_name_ << std::endl;
+        std::cout << "  array_elements: " << array_elements_ << std::endl;
+        std::cout << "  array_bytes: " << array_bytes_ << std::endl;
+        std::cout << "  stream_offset: " << array_offset_ << std::endl;
+        std::cout << "  iteration: " << iteration_ << std::endl;
+        std::cout << "  threads: " << num_threads_ << std::endl;
+        std::cout << "  cpu_node: " << cpu_node_ << std::endl;
+        std::cout << "  stream_scalar: " << scalar_ << std::endl;
+        std::cout << "  verify: " << (verify_ ? "true" : "false") << std::endl;
+        if (!array_nodes_.empty()) {
+            std::cout << "  stream_array_nodes: " << array_nodes_[0] << ", " << array_nodes_[1]
+                      << ", " << array_nodes_[2] << std::endl;
+        }
+    }
+
+    return true;
+}
+
+void StreamAccess::access() {
+    if (!initialized_) {
+        std::cerr << "StreamAccess not initialized" << std::endl;
+        return;
+    }
+    if (iteration_ <= 0) {
+        return;
+    }
+
+    std::vector<double> times(iteration_, 0.0);
+    SpinBarrier barrier(num_threads_);
+
+    auto worker = [&](int tid) {
+        size_t begin, end;
+        bind_to_node(cpu_node_);
+        thread_range(array_elements_, num_threads_, tid, &begin, &end);
+        for (int it = 0; it < iteration_; it++) {
+            std::chrono::steady_clock::time_point start;
+            barrier.wait();
+            if (tid == 0) {
+                start = std::chrono::steady_clock::now();
+            }
+            run_kernel(begin, end);
+            barrier.wait();
+            if (tid == 0) {
+                times[it] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+    };
+
+    // Thread 0 is spawned too, so cpu_node binding does not stick to the calling thread
+    std::vector<std::thread> workers;
+    for (int tid = 0; tid < num_threads_; tid++) {
+        workers.emplace_back(worker, tid);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // As in STREAM, the first iteration is excluded when there is more than one
+    int first = iteration_ > 1 ? 1 : 0;
+    double min_time = times[first], max_time = times[first], sum_time = 0.0;
+    for (int it = first; it < iteration_; it++) {
+        min_time = std::min(min_time, times[it]);
+        max_time = std::max(max_time, times[it]);
+        sum_time += times[it];
+    }
+    double avg_time = sum_time / (iteration_ - first);
+    double bytes = static_cast<double>(bytes_per_iteration());
+
+    std::string label = kernel_name_ + ":";
+    label[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(label[0])));
+    std::cout << "Function    Best Rate MB/s  Avg time     Min time     Max time" << std::endl;
+    std::cout << std::left << std::setw(12) << label << std::right << std::fixed
+              << std::setw(12) << std::setprecision(1) << 1.0e-6 * bytes / min_time << "  "
+              << std::setw(11) << std::setprecision(6) << avg_time << "  "
+              << std::setw(11) << min_time << "  "
+              << std::setw(11) << max_time << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+
+    if (verify_) {
+        if (verify_results()) {
+            std::cout << "Solution Validates" << std::endl;
+        } else {
+            std::cerr << "Error: " << kernel_name_ << " results failed validation" << std::endl;
+        }
+    }
+
+    if (verbose_) {
+        std::cout << "Stream " << kernel_name_ << " kernel executed" << std::endl;
+    }
+}
+
+bool StreamAccess::uses_array(int idx) const {
+    switch (kernel_) {
+        case Kernel::Copy:  return idx == 0 || idx == 2;  // a -> c
+        case Kernel::Scale: return idx == 1 || idx == 2;  // c -> b
+        default:            return true;
+    }
+}
+
+size_t StreamAccess::bytes_per_iteration() const {
+    // STREAM counts one read or write per array element, no write-allocate traffic
+    switch (kernel_) {
+        case Kernel::Copy:
+        case Kernel::Scale:
+            return 2 * array_bytes_;
+        default:
+            return 3 * array_bytes_;
+    }
+}
+
+void StreamAccess::run_kernel(size_t begin, size_t end) {
+    double* a = arrays_[0];
+    double* b = arrays_[1];
+    double* c = arrays_[2];
+    size_t n = end - begin;
+
+    switch (kernel_) {
+        case Kernel::Copy:
+            kernel_copy(c + begin, a + begin, n);
+            break;
+        case Kernel::Scale:
+            kernel_scale(b + begin, c + begin, scalar_, n);
+            break;
+        case Kernel::Add:
+            kernel_add(c + begin, a + begin, b + begin, n);
+            break;
+        case Kernel::Triad:
+            kernel_triad(a + begin, b + begin, c + begin, scalar_, n);
+            break;
+    }
+}
+
+void StreamAccess::fill_arrays(size_t begin, size_t end) {
+    for (int i = 0; i < 3; i++) {
+        if (arrays_[i]) {
+            std::fill(arrays_[i] + begin, arrays_[i] + end, kInitValue[i]);
+        }
+    }
+}
+
+bool StreamAccess::verify_results() const {
+    // Each kernel writes only its destination array, so repeated runs are idempotent
+    double expected[3] = {kInitValue[0], kInitValue[1], kInitValue[2]};
+    switch (kernel_) {
+        case Kernel::Copy:  expected[2] = expected[0]; break;
+        case Kernel::Scale: expected[1] = scalar_ * expected[2]; break;
+        case Kernel::Add:   expected[2] = expected[0] + expected[1]; break;
+        case Kernel::Triad: expected[0] = expected[1] + scalar_ * expected[2]; break;
+    }
+
+    const double epsilon = 1.0e-13;
+    bool valid = true;
+    for (int i = 0; i < 3; i++) {
+        if (!arrays_[i]) {
+            continue;
+        }
+        double err_sum = 0.0;
+        size_t err_count = 0;
+        for (size_t j = 0; j < array_elements_; j++) {
+            double err = std::fabs(arrays_[i][j] - expected[i]);
+            err_sum += err;
+            if (err / std::fabs(expected[i]) > epsilon) {
+                err_count++;
+            }
+        }
+        double avg_err = err_sum / array_elements_;
+        if (avg_err / std::fabs(expected[i]) > epsilon) {
+            std::cerr << "Failed Validation on array " << static_cast<char>('a' + i)
+                      << "[], AvgRelAbsErr > epsilon (" << epsilon << ")" << std::endl;
+            std::cerr << "     Expected Value: " << expected[i] << ", AvgAbsErr: " << avg_err
+                      << ", # of elements with error: " << err_count << std::endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+void StreamAccess::release_arrays() {
+    if (array_nodes_.empty()) {
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        deallocate_numa_memory(arrays_[i], array_bytes_);
+        arrays_[i] = nullptr;
+    }
+}